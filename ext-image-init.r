@@ -9,3 +9,18 @@ Rebol [
         See %extensions/image/README.md
     ]--
 ]
+
+sys.util/register-codec 'qoi %.qoi
+    identify-qoi?/
+    decode-qoi/
+    encode-qoi/
+
+; The BMP codec here only handles uncompressed 24 and 32 bit images, so
+; defer to a more complete one (e.g. from the BMP extension) if present.
+;
+if not select system.codecs 'bmp [
+    sys.util/register-codec 'bmp %.bmp
+        identify-bmp?/
+        decode-bmp/
+        encode-bmp/
+]
@@ -2,7 +2,15 @@ Rebol [
     name: Image
     notes: "See %extensions/README.md for the format and fields of this file"
 
-    extended-words: [rgb alpha]
+    extended-words: [
+        rgb alpha format
+        over in out atop xor multiply screen  ; BLEND modes
+        nearest bilinear lanczos3  ; RESIZE filters
+        clamp wrap transparent  ; CONVOLVE edges
+        rgba32 bgra32 rgb24 gray8 rgba16  ; CONVERT-FORMAT formats
+        pen fill width off line rect polygon circle  ; DRAW commands
+        rotate-90 rotate-180 rotate-270 flip-x flip-y transpose  ; TRANSFORM
+    ]
 
     extended-types: [image!]
 ]
@@ -10,3 +18,8 @@ Rebol [
 use-librebol: 'no  ; fiddles with Stubs/Nodes
 
 sources: [mod-image.c]
+
+libraries: all [  ; worker pool, see IMAGE_THREADS in %mod-image.c
+    platform-config.os-base != 'Windows
+    [%pthread]
+]
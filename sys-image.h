@@ -49,10 +49,108 @@
 
 #define LINK_IMAGE_WIDTH(s)     (s)->link.length
 #define MISC_IMAGE_HEIGHT(s)    (s)->misc.length
-// INFO not currently used
-// BONUS not currently used
+#define INFO_IMAGE_INFO(s)      (s)->info.base  // HANDLE! of ImageInfo, or null
+// BONUS can't be used: the holder is singular, so the cell occupies it
 
 
+//=//// IMAGE INFO RECORD /////////////////////////////////////////////////=//
+//
+// Most images need nothing beyond their width and height.  State that only
+// some images have lives in an ImageInfo struct, owned by a HANDLE! stub that
+// is referenced by the INFO slot.  It is only created when an image first
+// needs it, so plain images leave INFO null and cost no more.  The handle's
+// cleaner runs when the GC sweeps the image, which is how small images give
+// their pixel Binary back to the pool (see PIXEL POOL below).
+//
+// A "view" is an image whose pixels are a window onto another image's pixel
+// Binary.  The blob in the holder is positioned at the byte offset of the
+// window's top-left pixel, and the ImageInfo gives the row stride of the
+// backing store.  Writes through a view are seen by the image it was made
+// from, and vice versa.
+//
+// COPY of an image doesn't duplicate the pixels right away.  The copy gets
+// the same Binary, and both images are flagged as SHARED.  Whichever one is
+// written to first makes its own copy of the bytes at that point, and stops
+// being SHARED.  (There is no reference count, so the other one will still
+// make a copy on its first write.  That's wasteful in the rare case where
+// both are modified, but avoids needing to track who the sharers are.)
+//
+// Sharing only works if every holder of the Binary follows this protocol.
+// So images whose Binary is reachable some other way (it came from the user
+// in MAKE IMAGE!, was handed out by BYTES OF, or has views made of it) are
+// marked ALIASED, and COPY of those does a real copy.
+//
+// HASH of an image remembers the digest of its pixels, so hashing it again
+// (e.g. as a MAP! key) is free.  Every write to an image's pixels goes
+// through Image_Ensure_Mutable(), which forgets the digest.  But views and
+// ALIASED images can have their pixels changed by writes this extension
+// never sees, so their digests aren't kept.
+//
+// Pixels are RGBA with 8 bits per channel unless the ImageInfo says they are
+// in another PixelFormat (see CONVERT-FORMAT).  Images in other formats can
+// be sized, copied, compared, hashed, viewed, and have their pixels picked,
+// poked, and filled, with tuples converted to and from the format.  Anything
+// else needs RGBA32, and Image_Head() refuses to give out pixels otherwise.
+//
+
+typedef enum {
+    PIXEL_FORMAT_RGBA32,  // must be 0, what images without an ImageInfo use
+    PIXEL_FORMAT_BGRA32,
+    PIXEL_FORMAT_RGB24,
+    PIXEL_FORMAT_GRAY8,
+    PIXEL_FORMAT_RGBA16,  // 16 bits per channel, in native byte order
+    MAX_PIXEL_FORMAT = PIXEL_FORMAT_RGBA16
+} PixelFormat;
+
+INLINE Size Pixel_Format_Size(PixelFormat format) {  // bytes per pixel
+    static const Byte sizes[MAX_PIXEL_FORMAT + 1] = { 4, 4, 3, 1, 8 };
+    return sizes[format];
+}
+
+typedef struct {
+    REBLEN stride;  // pixels from one row to the next if a view, else 0
+    uint32_t flags;  // IMAGE_FLAG_XXX
+    REBLEN digest_pos;  // series position the digest was computed from
+    uint64_t digest;  // valid if IMAGE_FLAG_DIGEST
+    uint32_t format;  // PixelFormat
+} ImageInfo;
+
+#define IMAGE_FLAG_SHARED   (1 << 0)  // copy Binary before writing to it
+#define IMAGE_FLAG_ALIASED  (1 << 1)  // Binary visible outside the image
+#define IMAGE_FLAG_DIGEST   (1 << 2)  // digest is for the current pixels
+#define IMAGE_FLAG_POOLED   (1 << 3)  // ImageInfo is in a PixelPoolEntry
+
+INLINE Option(ImageInfo*) Image_Info(Image* img) {
+    Stub* handle = cast(Stub*, INFO_IMAGE_INFO(img));
+    if (not handle)
+        return nullptr;
+    return Cell_Handle_Pointer(ImageInfo, Stub_Cell(handle));
+}
+
+extern ImageInfo* Make_Image_Info(Image* img);  // in %mod-image.c
+
+INLINE ImageInfo* Ensure_Image_Info(Image* img) {
+    Option(ImageInfo*) existing = Image_Info(img);
+    if (existing)
+        return unwrap existing;
+    return Make_Image_Info(img);
+}
+
+
+INLINE bool Image_Has_Flag(Image* img, uint32_t flag) {
+    Option(ImageInfo*) info = Image_Info(img);
+    return info and ((unwrap info)->flags & flag);
+}
+
+#define Get_Image_Flag(img,name) \
+    Image_Has_Flag((img), IMAGE_FLAG_##name)
+
+#define Set_Image_Flag(img,name) \
+    (Ensure_Image_Info(img)->flags |= IMAGE_FLAG_##name)
+
+#define Clear_Image_Flag(img,name) \
+    (Ensure_Image_Info(img)->flags &= ~IMAGE_FLAG_##name)
+
 
 INLINE Image* VAL_IMAGE(const Cell* v) {
     assert(Is_Image(v));
@@ -63,11 +161,195 @@ INLINE Image* VAL_IMAGE(const Cell* v) {
 #define VAL_IMAGE_WIDTH(v)      LINK_IMAGE_WIDTH(VAL_IMAGE(v))
 #define VAL_IMAGE_HEIGHT(v)     MISC_IMAGE_HEIGHT(VAL_IMAGE(v))
 
+INLINE bool Is_Image_View(const Cell* v) {
+    Option(ImageInfo*) info = Image_Info(VAL_IMAGE(v));
+    return info and (unwrap info)->stride != 0;
+}
+
+INLINE REBLEN VAL_IMAGE_STRIDE(const Cell* v) {  // in pixels, not bytes
+    Option(ImageInfo*) info = Image_Info(VAL_IMAGE(v));
+    if (info and (unwrap info)->stride != 0)
+        return (unwrap info)->stride;
+    return VAL_IMAGE_WIDTH(v);
+}
+
+
+//=//// TILED IMAGES //////////////////////////////////////////////////////=//
+//
+// A tiled image keeps its pixels in TILE_SIZE x TILE_SIZE tiles instead of
+// one Binary, so a huge canvas only costs memory for the parts drawn on, and
+// nothing has to move when part of it changes.  The holder cell is a BLOCK!
+// with a cell per tile, row by row.  A tile that is all one color is just
+// a TUPLE! of that color (which is what every tile starts out as), and gets
+// a BLOB! of RGBA pixels when something less uniform is drawn on it.  Tiles
+// on the right and bottom edges are allocated full size.
+//
+// Tiled images are always RGBA32, and are never views or SHARED.  PICK,
+// POKE, CHANGE with fills and images, COPY, EQUAL? and HASH know about them,
+// as does Copy_Rect_Data(), so rectangles can be copied in and out.  Code
+// that wants contiguous pixels gets a panic from Image_Bytes_Head().
+//
+
+#define TILE_SHIFT  8
+#define TILE_SIZE   (1 << TILE_SHIFT)  // pixels on a side
+#define TILE_MASK   (TILE_SIZE - 1)
+#define TILE_BYTES  (TILE_SIZE * TILE_SIZE * 4)
+
+INLINE bool Is_Image_Tiled(const Cell* v) {
+    return Is_Block(VAL_IMAGE_BIN(v));
+}
+
+INLINE REBLEN Image_Tiles_Across(const Cell* v) {
+    return (VAL_IMAGE_WIDTH(v) + TILE_MASK) >> TILE_SHIFT;
+}
+
+INLINE Element* Image_Tile(const Cell* v, REBLEN x, REBLEN y) {  // has x, y
+    assert(Is_Image_Tiled(v));
+    Element* tiles = m_cast(Element*, List_Item_At(VAL_IMAGE_BIN(v)));
+    return tiles + ((y >> TILE_SHIFT) * Image_Tiles_Across(v))
+        + (x >> TILE_SHIFT);
+}
+
+
+INLINE PixelFormat Image_Format(const Cell* v) {
+    Option(ImageInfo*) info = Image_Info(VAL_IMAGE(v));
+    if (not info)
+        return PIXEL_FORMAT_RGBA32;
+    return cast(PixelFormat, (unwrap info)->format);
+}
+
+#define Image_Pixel_Size(v) \
+    Pixel_Format_Size(Image_Format(v))
+
+// A view's backing image could be shrunk by CLEAR or REMOVE after the view
+// was made, so before handing out pointers the window is checked to still
+// fit in the Binary.  This is for code that handles any PixelFormat.
+//
+INLINE Byte* Image_Bytes_Head(const Cell* v) {
+    if (Is_Image_Tiled(v))
+        panic ("Tiled IMAGE! has no contiguous pixels (COPY:PART a PAIR!)");
+
+    Binary* bin = Cell_Binary_Ensure_Mutable(VAL_IMAGE_BIN(v));
+    Size offset = Series_Index(VAL_IMAGE_BIN(v));
+    Option(ImageInfo*) info = Image_Info(VAL_IMAGE(v));
+    if (info and (unwrap info)->stride != 0 and VAL_IMAGE_HEIGHT(v) != 0) {
+        Size last = offset + (
+            (VAL_IMAGE_HEIGHT(v) - 1) * (unwrap info)->stride
+                + VAL_IMAGE_WIDTH(v)
+        ) * Image_Pixel_Size(v);
+        if (last > Binary_Len(bin))
+            panic ("IMAGE! view no longer fits in the image it was made from");
+    }
+    return Binary_Head(bin) + offset;
+}
+
+INLINE Byte* Image_Bytes_At_XY(const Cell* v, REBLEN x, REBLEN y) {
+    return Image_Bytes_Head(v)
+        + ((y * VAL_IMAGE_STRIDE(v)) + x) * Image_Pixel_Size(v);
+}
+
+// Run of contiguous pixels from linear position `pos`, as in Image_Run_At()
+//
+INLINE Byte* Image_Bytes_Run_At(
+    REBLEN* run,
+    const Cell* v,
+    REBLEN pos,
+    REBLEN len
+){
+    if (not Is_Image_View(v)) {
+        *run = len;
+        return Image_Bytes_Head(v) + (pos * Image_Pixel_Size(v));
+    }
+    REBLEN w = VAL_IMAGE_WIDTH(v);
+    REBLEN x = pos % w;
+    *run = MIN(len, w - x);
+    return Image_Bytes_At_XY(v, x, pos / w);
+}
+
+// Everything that doesn't go through the routines above gets its pixels
+// from here, and works only on RGBA32.
+//
+INLINE Byte* Image_Head(const Cell* v) {
+    if (Image_Format(v) != PIXEL_FORMAT_RGBA32)
+        panic ("IMAGE! must be RGBA32 for this (see CONVERT-FORMAT)");
+    return Image_Bytes_Head(v);
+}
+
 #define VAL_IMAGE_HEAD(v) \
-    Binary_Head(Cell_Binary_Ensure_Mutable(VAL_IMAGE_BIN(v)))
+    Image_Head(v)
+
+INLINE Byte* Image_At_XY(const Cell* v, REBLEN x, REBLEN y) {
+    return VAL_IMAGE_HEAD(v) + ((y * VAL_IMAGE_STRIDE(v)) + x) * 4;
+}
+
+INLINE Byte* Image_At_Index(const Cell* v, REBLEN pos) {
+    if (not Is_Image_View(v))
+        return VAL_IMAGE_HEAD(v) + (pos * 4);
+    REBLEN w = VAL_IMAGE_WIDTH(v);
+    return Image_At_XY(v, pos % w, pos / w);
+}
 
 #define VAL_IMAGE_AT_HEAD(v,pos) \
-    (VAL_IMAGE_HEAD(v) + (pos * 4))
+    Image_At_Index((v), (pos))
+
+// Code that loops over pixels (and any code that runs on other threads, which
+// can't call into the interpreter) works on a plain description of where the
+// pixels are.  Init_Pixmap() does the checks in Image_Head(), so it must be
+// called on the interpreter's thread.
+//
+typedef struct {
+    Byte* head;  // top-left pixel
+    REBLEN width;
+    REBLEN height;
+    REBLEN stride;  // pixels from the start of one row to the next
+} Pixmap;
+
+INLINE Pixmap* Init_Pixmap(Pixmap* pm, const Cell* v) {
+    pm->head = VAL_IMAGE_HEAD(v);
+    pm->width = VAL_IMAGE_WIDTH(v);
+    pm->height = VAL_IMAGE_HEIGHT(v);
+    pm->stride = VAL_IMAGE_STRIDE(v);
+    return pm;
+}
+
+#define Pixmap_At(pm,x,y) \
+    ((pm)->head + ((((y) * (pm)->stride) + (x)) * 4))
+
+// Operations which treat an image as a linear run of pixels can't assume
+// that the pixels are contiguous in memory if the image is a view.  This
+// gives back the address of the pixel at `pos` and how many of the `len`
+// pixels from there can be processed in one contiguous span.  Callers loop:
+//
+//     REBLEN run;
+//     for (; len > 0; pos += run, len -= run) {
+//         Byte* p = Pixmap_Run_At(&run, pm, pos, len);
+//         ...process `run` pixels at p...
+//     }
+//
+INLINE Byte* Pixmap_Run_At(
+    REBLEN* run,
+    const Pixmap* pm,
+    REBLEN pos,
+    REBLEN len
+){
+    if (pm->stride == pm->width) {
+        *run = len;
+        return pm->head + (pos * 4);
+    }
+    REBLEN x = pos % pm->width;
+    *run = MIN(len, pm->width - x);
+    return Pixmap_At(pm, x, pos / pm->width);
+}
+
+INLINE Byte* Image_Run_At(
+    REBLEN* run,
+    const Cell* v,
+    REBLEN pos,
+    REBLEN len
+){
+    Pixmap pm;
+    return Pixmap_Run_At(run, Init_Pixmap(&pm, v), pos, len);
+}
 
 
 // !!! The functions that take into account the current index position in the
@@ -92,24 +374,117 @@ INLINE REBLEN VAL_IMAGE_LEN_AT(const Cell* v) {
     return VAL_IMAGE_LEN_HEAD(v) - VAL_IMAGE_POS(v);
 }
 
-INLINE Element* Init_Image(
+//=//// OPERATION COUNTERS ////////////////////////////////////////////////=//
+//
+// While counting is switched on (see IMAGE-STATS-REPORT), the hot paths add
+// to a counter for the kind of work they do: how many calls, how many pixels
+// they touched, how many bytes they allocated, and how long they took.  When
+// it's off--the default--each costs a test of one global flag.  Counters are
+// only updated on the interpreter's thread, never inside the row bands.
+//
+
+typedef enum {
+    IMAGE_OP_ALLOCATE,  // new pixel buffers for images
+    IMAGE_OP_UNSHARE,  // deferred copies of COPY'd images, on first write
+    IMAGE_OP_EXPAND,  // INSERT and APPEND growing an image
+    IMAGE_OP_FILL,
+    IMAGE_OP_COPY_RECT,
+    IMAGE_OP_COPY_VALUE,
+    IMAGE_OP_FIND,
+    IMAGE_OP_EQUAL,
+    IMAGE_OP_HASH,
+    IMAGE_OP_STATS,
+    IMAGE_OP_MAP_PIXELS,
+    IMAGE_OP_BLEND,
+    IMAGE_OP_RESIZE,
+    IMAGE_OP_CONVOLVE,
+    IMAGE_OP_CONVERT,
+    IMAGE_OP_PIXELS,  // PICK-PIXELS and POKE-PIXELS
+    IMAGE_OP_TILE,  // tiles of tiled images getting pixels
+    IMAGE_OP_TEXT,  // DRAW-TEXT, pixels of glyphs drawn
+    IMAGE_OP_DRAW,  // DRAW, pixels of shapes composited
+    IMAGE_OP_TRANSFORM,
+    IMAGE_OP_ROWS,  // APPEND-ROWS of a BLOB!, pixels copied in
+    MAX_IMAGE_OP = IMAGE_OP_ROWS
+} ImageOp;
+
+typedef struct {
+    uint64_t calls;
+    uint64_t pixels;
+    uint64_t bytes;  // allocated
+    uint64_t nanoseconds;
+} ImageOpCounter;
+
+extern bool g_image_counting;
+extern ImageOpCounter g_image_op_counters[MAX_IMAGE_OP + 1];
+extern uint64_t Image_Clock_Nanoseconds(void);  // in %mod-image.c
+
+
+//=//// PIXEL POOL ////////////////////////////////////////////////////////=//
+//
+// Scripts that make many small images (icons, glyphs, crops) would pay for a
+// fresh pixel Binary each time.  So images of up to POOL_MAX_BYTES take their
+// Binary from a pool, sorted into size classes by powers of two.  The pool
+// keeps each of its Binaries alive, and an image using one gets an ImageInfo
+// that lives in the pool entry, flagged POOLED.  When the GC sweeps the image,
+// the ImageInfo's handle cleaner puts the Binary back on its class's list.
+//
+// That is only safe while the image is the Binary's one user.  COPY sharing
+// it, views of it, and BYTES OF all call Unpool_Image() first, which lets the
+// Binary go to the GC like any other.
+//
+
+#define POOL_MIN_SHIFT  8  // 256 bytes, an 8x8 image
+#define POOL_MAX_SHIFT  14  // 16K bytes, a 64x64 image
+#define POOL_MAX_BYTES  (1 << POOL_MAX_SHIFT)
+
+extern Binary* Make_Pixel_Binary(Image* img, Size size);  // in %mod-image.c
+extern void Unpool_Image(Image* img);
+
+
+// Start timing an operation, 0 if not counting.
+//
+INLINE uint64_t Image_Op_Start(void) {
+    if (not g_image_counting)
+        return 0;
+    return Image_Clock_Nanoseconds();
+}
+
+INLINE void Count_Image_Op(
+    ImageOp op,
+    uint64_t start,  // from Image_Op_Start()
+    uint64_t pixels,
+    uint64_t bytes
+){
+    if (not g_image_counting or start == 0)
+        return;  // (or counting started in the middle of the operation)
+
+    ImageOpCounter* c = &g_image_op_counters[op];
+    ++c->calls;
+    c->pixels += pixels;
+    c->bytes += bytes;
+    c->nanoseconds += Image_Op_Start() - start;
+}
+
+
+// Make the image stub, leaving its holder cell for the caller to fill in
+// with the BLOB! of the pixels (or BLOCK! of tiles).
+//
+INLINE Element* Init_Image_Holder(
     Init(Element) out,
-    const Binary* bin,
     REBLEN width,
     REBLEN height
 ){
-    assert(Is_Base_Managed(bin));
-
     require (
       Array* blob_holder = u_downcast Prep_Stub(
         FLAG_FLAVOR(FLAVOR_CELLS)
             | BASE_FLAG_MANAGED
             | (not STUB_FLAG_LINK_NEEDS_MARK)  // width, integer
             | (not STUB_FLAG_MISC_NEEDS_MARK)  // height, integer
-            | (not STUB_FLAG_INFO_NEEDS_MARK),  // info, not used ATM
+            | STUB_FLAG_INFO_NEEDS_MARK,  // ImageInfo handle (or null)
         Alloc_Stub()
     ));
-    Init_Blob(Force_Erase_Cell(Stub_Cell(blob_holder)), bin);
+    INFO_IMAGE_INFO(blob_holder) = nullptr;  // created on demand
 
     Reset_Extended_Cell_Header_Noquote(
         out,
@@ -125,9 +500,28 @@ INLINE Element* Init_Image(
 
     VAL_IMAGE_POS(out) = 0;  // !!! sketchy concept, is in BINARY!
 
+    return cast(Element*, Force_Erase_Cell(Stub_Cell(blob_holder)));
+}
+
+// The byte `offset` is where the top-left pixel is in the Binary.  This is
+// zero for images that own their pixels, and only nonzero for views.
+//
+INLINE Element* Init_Image_At(
+    Init(Element) out,
+    const Binary* bin,
+    Size offset,
+    REBLEN width,
+    REBLEN height
+){
+    assert(Is_Base_Managed(bin));
+
+    Init_Blob_At(Init_Image_Holder(out, width, height), bin, offset);
     return out;
 }
 
+#define Init_Image(out,bin,width,height) \
+    Init_Image_At((out), (bin), 0, (width), (height))
+
 INLINE void RESET_IMAGE(Byte* p, REBLEN num_pixels) {
     Byte* start = p;
     Byte* stop = start + (num_pixels * 4);
@@ -139,6 +533,31 @@ INLINE void RESET_IMAGE(Byte* p, REBLEN num_pixels) {
     }
 }
 
+// Creates WxH image whose pixel bytes have not been written.  This is for
+// callers that will overwrite every pixel anyway, so they don't pay for a
+// RESET_IMAGE pass over the whole buffer first.
+//
+INLINE Cell* Init_Image_Format_Unfilled(
+    Init(Element) out,
+    REBLEN w,
+    REBLEN h,
+    PixelFormat format
+){
+    uint64_t start = Image_Op_Start();
+
+    Element* holder = Init_Image_Holder(out, w, h);
+    Size size = (w * h) * Pixel_Format_Size(format);
+    Init_Blob(holder, Make_Pixel_Binary(VAL_IMAGE(out), size));
+    Count_Image_Op(IMAGE_OP_ALLOCATE, start, w * h, size);
+
+    if (format != PIXEL_FORMAT_RGBA32)
+        Ensure_Image_Info(VAL_IMAGE(out))->format = format;
+    return out;
+}
+
+#define Init_Image_Unfilled(out,w,h) \
+    Init_Image_Format_Unfilled((out), (w), (h), PIXEL_FORMAT_RGBA32)
+
 // Creates WxH image, black pixels, all opaque.
 //
 INLINE Cell* Init_Image_Black_Opaque(
@@ -146,12 +565,10 @@ INLINE Cell* Init_Image_Black_Opaque(
     REBLEN w,
     REBLEN h
 ){
-    Size size = (w * h) * 4;  // RGBA pixels, 4 bytes each
-    Binary* bin = Make_Binary(size);
-    Term_Binary_Len(bin, size);
-    Manage_Stub(bin);
-
-    RESET_IMAGE(Binary_Head(bin), (w * h));  // length in 'pixels'
+    Init_Image_Unfilled(out, w, h);
 
-    return Init_Image(out, bin, w, h);
+    uint64_t start = Image_Op_Start();
+    RESET_IMAGE(VAL_IMAGE_HEAD(out), (w * h));  // length in 'pixels'
+    Count_Image_Op(IMAGE_OP_FILL, start, w * h, 0);
+    return out;
 }
@@ -0,0 +1,158 @@
+Rebol [
+    title: "IMAGE! Extension Benchmarks"
+    file: %image.bench.r
+
+    notes: --[
+        Times the IMAGE! operations whose cost grows with the number of
+        pixels, on synthetic images of a few fixed sizes.  The pixels come
+        from RANDOM with a fixed seed, so every run (and every build) sees
+        the same images.
+
+        Results are printed as CSV, one line per operation and size:
+
+            op,size,width,height,workers,iterations,ns-per-pixel,gb-per-sec
+
+        GB/s counts the bytes the operation has to read and write per pixel
+        (e.g. 8 for a copy, 4 for a fill), so it can be compared against the
+        memory bandwidth of the machine.  Each operation is repeated until it
+        has run for at least MIN-TIME, doubling the count each try.
+
+        To check a change for regressions, run this with the build before
+        and after it and compare the ns-per-pixel columns.
+    ]--
+]
+
+min-time: 0.25  ; seconds
+
+sizes: [
+    "64" 64x64
+    "1080p" 1920x1080
+    "8k" 7680x4320
+]
+
+pick-poke-count: 65536  ; PICK/POKE go through the evaluator, so cap them
+
+
+; A 64x64 tile of random opaque pixels is repeated to fill each image, so
+; building the 8K one doesn't take longer than the benchmarks themselves.
+;
+random:seed 1020
+tile: make blob! 64 * 64 * 4
+repeat 64 * 64 [
+    append tile (random 256) - 1  ; red
+    append tile (random 256) - 1  ; green
+    append tile (random 256) - 1  ; blue
+    append tile 255  ; opaque, so FIND for a transparent color scans it all
+]
+tile: make image! compose [64x64 (tile)]
+
+make-synthetic: func [
+    "Fill an image of SIZE with copies of the random tile"
+    return: [image!]
+    size [pair!]
+][
+    let img: make image! size
+    let y: 0
+    while [y < size.y] [
+        let x: 0
+        while [x < size.x] [
+            change (at img make pair! reduce [x y]) tile
+            x: x + 64
+        ]
+        y: y + 64
+    ]
+    return head img
+]
+
+measure: func [
+    "Run BODY until it takes MIN-TIME, return [iterations seconds]"
+    return: [block!]
+    body [block!]
+][
+    let n: 1
+    cycle [
+        let start: now:precise
+        repeat n body
+        let seconds: to decimal! difference now:precise start
+        if seconds >= min-time [
+            return reduce [n seconds]
+        ]
+        n: n * 2
+    ]
+]
+
+bench: func [
+    "Time BODY and print a CSV line for it"
+    op [text!]
+    name [text!]
+    size [pair!]
+    pixels "Pixels each run of BODY touches"
+        [integer!]
+    bytes "Bytes read and written per pixel"
+        [integer!]
+    body [block!]
+][
+    let result: measure body
+    let iterations: result.1
+    let seconds: result.2
+    let total: iterations * pixels
+    print delimit "," reduce [
+        op name size.x size.y (image-workers) iterations
+        round:to (seconds * 1e9 / total) 0.001
+        round:to (total * bytes / seconds / 1e9) 0.001
+    ]
+]
+
+
+print "op,size,width,height,workers,iterations,ns-per-pixel,gb-per-sec"
+
+for-each [name size] sizes [
+    let img: make-synthetic size
+    let pixels: size.x * size.y
+
+    bench "make" name size pixels 4 [
+        make image! size
+    ]
+
+    bench "copy-part" name size pixels 8 [
+        copy:part img size
+    ]
+
+    bench "change-dup" name size pixels 4 [
+        change:dup img 10.20.30 size
+    ]
+    img: make-synthetic size  ; put the random pixels back
+
+    let count: min pixels pick-poke-count
+    bench "pick-poke" name size count 8 [
+        let i: 1
+        repeat count [
+            poke img i (pick img i)
+            i: i + 1
+        ]
+    ]
+
+    bench "find" name size pixels 4 [
+        find img 1.2.3.0  ; no pixel is transparent, so never found
+    ]
+
+    bench "complement" name size pixels 8 [
+        complement img
+    ]
+
+    bench "rgb" name size pixels 7 [
+        img.rgb
+    ]
+
+    bench "alpha" name size pixels 5 [
+        img.alpha
+    ]
+
+    bench "poke-rgb" name size pixels 8 [  ; fill that keeps each alpha
+        img.rgb: 10.20.30
+    ]
+
+    bench "poke-alpha" name size pixels 8 [
+        img.alpha: 128
+    ]
+]
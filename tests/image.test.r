@@ -123,3 +123,735 @@
 ((make image! [1x1 #{ffffffff}]) = not+ make image! [1x1 #{00000000}])
 
 (false = not make image! 0x0)
+
+; Fills go through 32-bit pixel lanes, make sure RGB-only and alpha-only
+; stores leave the other bytes alone.
+(
+    img: make image! 3x2
+    change:dup img 10.20.30.40 4
+    all [
+        img.1 = 10.20.30.40
+        img.4 = 10.20.30.40
+        img.5 = 0.0.0.255
+    ]
+)
+(
+    img: make image! 3x2
+    change:dup img 128 2x2
+    all [
+        img.1 = 0.0.0.128
+        img.2 = 0.0.0.128
+        img.3 = 0.0.0.255
+        img.5 = 0.0.0.128
+    ]
+)
+(
+    img: make image! [2x2 #{01020304 05060708 090A0B0C 0D0E0F10}]
+    img.rgb: 255.0.255
+    all [
+        img.1 = 255.0.255.4
+        img.4 = 255.0.255.16
+    ]
+)
+
+; Channel extraction works four pixels at a time with a scalar tail, check
+; runs both shorter and longer than that block size.
+(
+    img: make image! [5x1 #{01020304 05060708 090A0B0C 0D0E0F10 11121314}]
+    all [
+        img.rgb = #{010203 050607 090A0B 0D0E0F 111213}
+        img.alpha = #{04080C1014}
+    ]
+)
+(
+    img: make image! [3x1 #{01020304 05060708 090A0B0C}]
+    all [
+        img.rgb = #{010203 050607 090A0B}
+        img.alpha = #{04080C}
+    ]
+)
+(
+    img: make image! 5x1
+    img.rgb: #{010203 050607 090A0B 0D0E0F 111213}
+    img.alpha: #{04080C1014}
+    img = make image! [5x1 #{01020304 05060708 090A0B0C 0D0E0F10 11121314}]
+)
+(
+    img: make image! [5x1 #{01020304 05060708 090A0B0C 0D0E0F10 11121314}]
+    img.rgb: #{FFFFFF FFFFFF}  ; short data only changes leading pixels
+    all [
+        img.1 = 255.255.255.4
+        img.2 = 255.255.255.8
+        img.3 = 9.10.11.12
+    ]
+)
+
+; MAKE IMAGE! from a block of tuples writes pixels in one pass, with any
+; pixels not supplied left black and opaque.
+(
+    img: make image! [3x1 [1.2.3.4 5.6.7.8]]
+    all [
+        img.1 = 1.2.3.4
+        img.2 = 5.6.7.8
+        img.3 = 0.0.0.255
+    ]
+)
+(
+    img: make image! [2x2 10.20.30]
+    all [img.1 = 10.20.30.255, img.4 = 10.20.30.255]
+)
+(
+    img: make image! [2x2 10.20.30 64]
+    all [img.1 = 10.20.30.64, img.4 = 10.20.30.64]
+)
+
+; SUBIMAGE makes a view sharing pixels with the image it was made from
+(
+    img: make image! [3x3 [
+        1.1.1.255 2.2.2.255 3.3.3.255
+        4.4.4.255 5.5.5.255 6.6.6.255
+        7.7.7.255 8.8.8.255 9.9.9.255
+    ]]
+    v: subimage img 1x1 2x2
+    all [
+        v.size = 2x2
+        v.1 = 5.5.5.255
+        v.2 = 6.6.6.255
+        v.3 = 8.8.8.255
+        v = make image! [2x2 [5.5.5.255 6.6.6.255 8.8.8.255 9.9.9.255]]
+        v.rgb = #{050505 060606 080808 090909}
+    ]
+)
+(
+    img: make image! 3x3
+    v: subimage img 1x0 2x2
+    change:dup v 255.0.0 4
+    all [
+        img.1 = 0.0.0.255
+        img.2 = 255.0.0.255
+        img.3 = 255.0.0.255
+        img.4 = 0.0.0.255
+        img.5 = 255.0.0.255
+        img.7 = 0.0.0.255
+    ]
+)
+(
+    img: make image! 4x4
+    v: subimage img 3x3 10x10  ; clipped to the image
+    v.size = 1x1
+)
+(
+    img: make image! [2x2 [1.1.1.255 2.2.2.255 3.3.3.255 4.4.4.255]]
+    v: subimage img 0x1 2x1
+    c: copy v
+    c.1: 9.9.9.255
+    all [
+        img.3 = 3.3.3.255
+        (bytes of v) = #{030303FF 040404FF}
+    ]
+)
+(
+    img: make image! [3x2 [
+        1.1.1.255 2.2.2.255 3.3.3.255
+        4.4.4.255 5.5.5.255 6.6.6.255
+    ]]
+    v: subimage img 1x0 2x2
+    pos: find v 5.5.5
+    all [
+        3 = index of pos
+        null? find v 4.4.4
+    ]
+)
+
+; COPY shares pixels until one of the images is written to
+(
+    a: make image! [2x1 [1.2.3.255 4.5.6.255]]
+    b: copy a
+    b.1: 9.9.9.255
+    all [
+        a.1 = 1.2.3.255
+        b.1 = 9.9.9.255
+        b.2 = 4.5.6.255
+    ]
+)
+(
+    a: make image! [2x1 [1.2.3.255 4.5.6.255]]
+    b: copy a
+    change a 7.7.7
+    all [
+        a.1 = 7.7.7.255
+        b.1 = 1.2.3.255
+    ]
+)
+(
+    a: make image! 2x1
+    b: copy a
+    remove a
+    all [
+        a.size = 1x1
+        b.size = 2x1
+    ]
+)
+(
+    bin: #{01020304 05060708}
+    a: make image! reduce [2x1 bin]
+    b: copy a  ; the BLOB! is aliased, so this copy can't be deferred
+    change bin #{FF}
+    all [
+        a.1 = 255.2.3.4
+        b.1 = 1.2.3.4
+    ]
+)
+
+; QOI round trip, exercising runs, diffs, luma, index and full RGBA chunks
+(
+    img: make image! [4x2 [
+        0.0.0.255 0.0.0.255 1.1.1.255 40.10.20.255
+        40.10.20.128 200.100.50.255 1.1.1.255 1.2.1.255
+    ]]
+    all [
+        binary? data: encode 'qoi img
+        img = decode 'qoi data
+    ]
+)
+(
+    img: make image! [3x3 10.20.30 40]
+    img = decode 'qoi encode 'qoi img
+)
+(
+    img: make image! [3x2 [  ; opaque, BMP codecs may not keep alpha
+        1.2.3.255 4.5.6.255 8.9.10.255
+        12.13.14.255 16.17.18.255 20.21.22.255
+    ]]
+    img = decode 'bmp encode 'bmp img
+)
+
+; READ-RAW-IMAGE reads raw RGBA pixels straight from a file
+(
+    img: make image! [3x2 [
+        1.1.1.1 2.2.2.2 3.3.3.3
+        4.4.4.4 5.5.5.5 6.6.6.6
+    ]]
+    file: join (local-to-file:dir any [
+        get-env "TMPDIR" get-env "TEMP" "/tmp"
+    ]) %raw-image-test.rgba
+    write file join #{CAFE} bytes of img
+    ok: all [
+        img = read-raw-image:offset file 3x2 2
+        (make image! [2x1 [5.5.5.5 6.6.6.6]])
+            = read-raw-image:offset:at:part file 3x2 2 1x1 5x5
+    ]
+    delete file  ; even if the checks failed
+    ok
+)
+
+; Big images are split across threads, results don't depend on how many
+(
+    workers: image-workers
+    img: make image! [1024x512 10.20.30]
+    img.alpha: 128
+    change:dup skip img 1000 255.0.0 5000
+    image-workers:set 1
+    one: complement img
+    image-workers:set 4
+    four: complement img
+    image-workers:set workers
+    all [
+        workers >= 1
+        one = four
+        (pick one 1) = 245.235.225.127
+    ]
+)
+
+; BLEND composites with alpha, clipped to the target
+(
+    canvas: make image! [3x1 0.0.0]
+    sprite: make image! [2x1 255.255.255 128]
+    blend:at canvas sprite 2x0
+    all [
+        (pick canvas 1) = 0.0.0.255
+        (pick canvas 3) = 128.128.128.255
+    ]
+)
+(
+    canvas: make image! [2x2 10.20.30]
+    blend canvas make image! [2x2 1.2.3 0]  ; fully transparent, no change
+    canvas = make image! [2x2 10.20.30]
+)
+(
+    canvas: make image! [1x1 200.200.200]
+    blend:mode canvas make image! [1x1 100.100.100] 'multiply
+    (pick canvas 1) = 78.78.78.255
+)
+(
+    canvas: make image! [1x1 200.200.200]
+    blend:mode canvas make image! [1x1 1.2.3] 'xor
+    (pick canvas 1) = 0.0.0.0
+)
+(
+    canvas: make image! [2x2 [1.1.1.255 2.2.2.255 3.3.3.255 4.4.4.255]]
+    blend:at canvas subimage canvas 0x0 2x2 1x1  ; pixels of the same image
+    (pick canvas 4) = 1.1.1.255
+)
+
+; RESIZE scales with separable filters
+(
+    img: make image! [3x2 10.20.30]
+    all [
+        (make image! [6x4 10.20.30]) = resize img 6x4
+        (make image! [1x1 10.20.30]) = resize:filter img 1x1 'lanczos3
+        (make image! [2x5 10.20.30]) = resize:filter img 2x5 'nearest
+    ]
+)
+(
+    img: make image! [2x1 [0.0.0.255 255.255.255.255]]
+    all [
+        (pick resize img 1x1 1) = 128.128.128.255
+        (pick resize:filter img 4x1 'nearest 2) = 0.0.0.255
+        (pick resize:filter img 4x1 'nearest 3) = 255.255.255.255
+    ]
+)
+(
+    img: make image! [2x1 [255.0.0.255 0.255.0.0]]  ; transparent green
+    (pick resize img 1x1 1) = 255.0.0.128  ; doesn't bleed into the red
+)
+
+; CONVOLVE filters with a kernel, flat areas stay flat whatever the path
+(
+    img: make image! [5x4 90.60.30]
+    all [
+        img = convolve img [1 1 1 1 1 1 1 1 1]  ; box
+        img = convolve img [1 2 1 2 4 2 1 2 1]  ; separable
+        img = convolve img [0 -1 0 -1 5 -1 0 -1 0]  ; sharpen
+        img = convolve img [5]
+    ]
+)
+(
+    img: make image! [3x1 [0.0.0.255 90.90.90.255 0.0.0.255]]
+    all [
+        (pick convolve img [0 0 0 1 1 1 0 0 0] 1) = 30.30.30.255
+        (pick convolve:edge img [0 0 0 1 1 1 0 0 0] 'transparent 1)
+            = 30.30.30.170
+        (pick convolve:edge img [0 0 0 1 0 1 0 0 0] 'wrap 1)
+            = 45.45.45.255
+    ]
+)
+
+; HASH agrees with EQUAL?, and notices writes
+(
+    a: make image! [4x3 1.2.3]
+    b: copy a
+    all [
+        (hash a) = hash b
+        (hash a) = hash make image! [4x3 1.2.3]
+        (hash a) = hash subimage make image! [5x5 1.2.3] 1x1 4x3
+        (hash a) <> hash make image! [4x3 1.2.4]
+        (hash a) <> hash make image! [3x4 1.2.3]
+        elide poke b 1 9.9.9
+        (hash a) <> hash b
+        a <> b
+    ]
+)
+
+; FIND looks for colors, alphas, runs of pixels and whole sub-images
+(
+    img: make image! [20x3 10.10.10]
+    poke img 27 1.2.3.4
+    poke img 45 1.2.3.255
+    all [
+        27 = index of find img 1.2.3
+        45 = index of find img 1.2.3.255
+        27 = index of find img 4
+        null? find:part img 1.2.3 20
+        45 = index of find:skip img 1.2.3 4
+        null? find:match img 1.2.3
+        28 = index of find:match skip img 26 1.2.3
+        27 = index of find img #{01020304 0A0A0AFF}
+        null? find img #{01020304 01020304}
+    ]
+)
+(
+    tpl: make image! [2x2 [1.1.1.255 2.2.2.255 3.3.3.255 4.4.4.255]]
+    canvas: make image! [6x5 0.0.0]
+    blend:at canvas tpl 3x2
+    poke canvas 2 1.1.1.255  ; top row alone matches at 1x0, decoy
+    poke canvas 3 2.2.2.255
+    all [
+        16 = index of find canvas tpl
+        24 = index of find:match skip canvas 15 tpl
+        null? find skip canvas 16 tpl
+    ]
+)
+
+; IMAGE-STATS counts every channel in one pass
+(
+    stats: image-stats make image! [2x2 [
+        10.20.30.255 10.20.30.255 30.20.10.0 30.20.10.255
+    ]]
+    all [
+        stats.pixels = 4
+        stats.opaque = 3
+        stats.transparent = 1
+        stats.min = [10 20 10 0]
+        stats.max = [30 20 30 255]
+        stats.mean.1 = 20.0
+        stats.variance.1 = 100.0
+        stats.variance.2 = 0.0
+        2 = pick stats.histogram.1 11
+        4 = pick stats.histogram.2 21
+    ]
+)
+(
+    stats: image-stats make image! []
+    all [stats.pixels = 0, stats.min = []]
+)
+
+; MAP-PIXELS runs lookup tables, swizzles and color matrices
+(
+    img: make image! [2x1 10.20.30 128]
+    invert: make blob! 256
+    repeat 256 [append invert 255 - length of invert]
+    c: map-pixels:copy img invert
+    all [
+        (pick c 2) = 245.235.225.128
+        (pick img 2) = 10.20.30.128
+    ]
+)
+(
+    img: make image! [2x1 10.20.30 128]
+    map-pixels img [0 0 1 0 0  0 1 0 0 0  1 0 0 0 0  0 0 0 1 0]
+    (pick img 1) = 30.20.10.128
+)
+(
+    img: make image! [2x1 10.20.30 128]
+    map-pixels img [1 0 0 0 0.2  0 1 0 0 0  0 0 1 0 0  0 0 0 0.5 0]
+    (pick img 1) = 61.20.30.64
+)
+(
+    img: make image! [1x1 200.20.30]
+    map-pixels img [-2 0 0 0 2  0 1 0 0 0  0 0 1 0 0  0 0 0 1 0]
+    (pick img 1) = 110.20.30.255  ; constants go up to 256, as weights do
+)
+(
+    img: make image! [2x1 10.20.30 128]
+    invert: make blob! 1024
+    repeat 4 [repeat 256 [append invert 255 - (modulo length of invert 256)]]
+    (complement img) = map-pixels:copy img invert
+)
+
+; CONVERT-FORMAT stores pixels as BGRA32, RGB24, GRAY8, or RGBA16
+(
+    img: make image! [2x1 10.20.30 128]
+    bgra: convert-format img 'bgra32
+    all [
+        bgra.format = 'bgra32
+        (bytes of bgra) = #{1E140A801E140A80}
+        (pick bgra 1) = 10.20.30.128
+        img <> bgra
+        img = convert-format bgra 'rgba32
+    ]
+)
+(
+    img: make image! [2x1 10.20.30 128]
+    rgb: convert-format img 'rgb24
+    all [
+        (bytes of rgb) = #{0A141E0A141E}
+        (pick rgb 2) = 10.20.30.255
+        18.18.18.255 = pick convert-format img 'gray8 1
+    ]
+)
+(
+    img: make image! [2x1 10.20.30 128]
+    wide: convert-format img 'rgba16
+    all [
+        16 = length of bytes of wide
+        img = convert-format wide 'rgba32
+        (hash wide) = hash copy wide
+    ]
+)
+(
+    gray: convert-format make image! [3x2 0.0.0] 'gray8
+    change:dup gray 255.255.255 2x2
+    poke gray 6 128.128.128
+    (bytes of gray) = #{FFFF00FFFF80}
+)
+
+; TILED-IMAGE only allocates the tiles that are drawn on
+(
+    big: tiled-image:fill 40000x40000 10.20.30
+    all [
+        big.size = 40000x40000
+        (pick big 1) = 10.20.30.255
+        (pick big 1600000000) = 10.20.30.255
+    ]
+)
+(
+    big: tiled-image 1000x1000
+    poke big 1001 1.2.3.4  ; pixel 0x1
+    change:dup (at big 300x250) 255.0.0 300x300  ; crosses tile edges
+    part: copy:part (at big 299x249) 3x3
+    all [
+        (pick big 1001) = 1.2.3.4
+        (pick part 1) = 0.0.0.255
+        (pick part 5) = 255.0.0.255
+        (pick part 9) = 255.0.0.255
+        (copy:part (at big 300x250) 300x300)
+            = make image! [300x300 255.0.0]
+    ]
+)
+(
+    big: tiled-image 600x600
+    small: make image! [2x2 [1.1.1 2.2.2 3.3.3 4.4.4]]
+    change (at big 255x255) small  ; one pixel in each of four tiles
+    flat: copy:part (at big 255x255) 2x2
+    all [
+        flat = small
+        (copy big) = big
+        (hash copy big) = hash big
+    ]
+)
+(
+    big: protect tiled-image 300x300  ; writes go straight to the tiles
+    all [
+        ~series-protected~ !! (poke big 1 255.0.0)
+        ~series-protected~ !! (change big 255.0.0)
+        ~series-protected~ !! (poke-pixels big [0x0] 255.0.0)
+        (pick big 1) = 0.0.0.255
+    ]
+)
+
+; IMAGE-STATS-REPORT counts work done while counting is on
+(
+    image-stats-report:stop:reset
+    img: make image! 10x10
+    before: image-stats-report:start
+    copy:part img 5x5
+    change:dup img 1.2.3 10x10
+    report: image-stats-report:stop:reset
+    all [
+        before.allocate.calls = 0
+        report.copy-rect.calls = 1
+        report.copy-rect.pixels = 25
+        report.fill.pixels = 100
+        report.allocate.bytes = 100
+        0 = select (select image-stats-report 'fill) 'calls
+    ]
+)
+
+; PICK-PIXELS and POKE-PIXELS work on batches of coordinates
+(
+    img: make image! 4x3
+    poke-pixels img [0x0 3x2 -1x0 4x0] 255.0.0
+    poke-pixels img [1x1 2x1] #{0102030405060708}
+    all [
+        (pick img 1) = 255.0.0.255
+        (pick img 12) = 255.0.0.255
+        (pick img 6) = 1.2.3.4
+        (pick img 7) = 5.6.7.8
+        (pick-pixels img [3x2 1x1 9x9]) = #{FF0000FF0102030400000000}
+        (pick-pixels:outside img [-1x-1] 9.9.9.9) = #{09090909}
+    ]
+)
+
+; APPEND-ROWS grows an image in place, RESERVE-ROWS makes room ahead
+(
+    img: make image! 0x0
+    row: make image! [3x1 [1.1.1 2.2.2 3.3.3]]
+    repeat 100 [append-rows img row]  ; takes on the width of the first row
+    append-rows img #{0A0B0C0D 0A0B0C0D 0A0B0C0D}
+    all [
+        img.size = 3x101
+        (pick img 1) = 1.1.1.255
+        (pick img 300) = 3.3.3.255
+        (pick img 303) = 10.11.12.13
+    ]
+)
+(
+    img: make image! [3x1 [1.1.1 2.2.2 3.3.3]]
+    row: make image! [3x1 [1.1.1 2.2.2 3.3.3]]  ; (COPY would share pixels)
+    reserve-rows img 100
+    image-stats-report:reset:start
+    repeat 99 [append-rows img row]
+    append-rows img #{0A0B0C0D 0A0B0C0D 0A0B0C0D}
+    report: image-stats-report:stop:reset
+    all [
+        img.size = 3x101
+        (pick img 300) = 3.3.3.255
+        (pick img 303) = 10.11.12.13
+        0 = select (select report 'expand) 'calls  ; no reallocation
+        1 = select (select report 'rows) 'calls
+    ]
+)
+(
+    img: make image! [2x1 [1.2.3 4.5.6]]
+    repeat 6 [append-rows img bytes of img]  ; its own pixels, no reserve
+    all [
+        img.size = 2x64
+        (pick img 1) = 1.2.3.255
+        (pick img 128) = 4.5.6.255
+    ]
+)
+(
+    img: make image! [2x1 [1.2.3 4.5.6]]
+    append img make image! [2x1 [7.8.9 10.11.12]]
+    all [
+        img.size = 2x2
+        (pick img 3) = 7.8.9.255
+        (pick img 4) = 10.11.12.255
+    ]
+)
+
+; Small images reuse pixel Binaries the GC has given back to the pool
+(
+    image-pool-stats:reset
+    repeat 20 [make image! 16x16]
+    recycle
+    repeat 20 [make image! 16x16]
+    stats: image-pool-stats
+    all [
+        0 < select stats 'returned
+        0 < select stats 'hits
+    ]
+)
+(
+    a: make image! [2x1 [1.2.3 4.5.6]]
+    b: copy a  ; shares the pooled Binary, so it must not be reused
+    a: null
+    recycle
+    repeat 20 [make image! 2x1]
+    (pick b 2) = 4.5.6.255
+)
+
+; DRAW-TEXT with a BDF font, drawing glyphs again from the atlas
+(
+    file: join (local-to-file:dir any [
+        get-env "TMPDIR" get-env "TEMP" "/tmp"
+    ]) %draw-text-test.bdf
+    write file --[STARTFONT 2.1
+FONT test
+SIZE 2 75 75
+FONTBOUNDINGBOX 3 2 0 0
+FONT_ASCENT 2
+FONT_DESCENT 0
+CHARS 1
+STARTCHAR A
+ENCODING 65
+DWIDTH 3 0
+BBX 2 2 0 0
+BITMAP
+C0
+C0
+ENDCHAR
+ENDFONT
+]--
+    img: make image! [4x4 255.255.255]
+    draw-text:color img 1x1 "A" file 255.0.0
+    big: make image! [8x8 255.255.255]
+    draw-text:scale big 0x0 "AA" file 2
+    delete file  ; the font stays loaded
+    all [
+        (pick img 1) = 255.255.255.255
+        (pick img 6) = 255.0.0.255
+        (pick img 11) = 255.0.0.255
+        (pick img 12) = 255.255.255.255
+        (pick big 1) = 0.0.0.255
+        (pick big 12) = 0.0.0.255
+        (pick big 5) = 255.255.255.255  ; gap before the second glyph
+        (pick big 7) = 0.0.0.255  ; second glyph, clipped at the right
+    ]
+)
+(
+    file: join (local-to-file:dir any [
+        get-env "TMPDIR" get-env "TEMP" "/tmp"
+    ]) %draw-text-wide.bdf
+    write file --[STARTFONT 2.1
+FONT wide
+SIZE 20 75 75
+FONTBOUNDINGBOX 20 1 0 0
+FONT_ASCENT 1
+FONT_DESCENT 0
+CHARS 1
+STARTCHAR A
+ENCODING 65
+DWIDTH 20 0
+BBX 20 1 0 0
+BITMAP
+FFFFF0
+ENDCHAR
+ENDFONT
+]--
+    img: make image! [8x8 255.255.255]
+    e1: sys.util/rescue [draw-text:scale img 0x0 "A" file 64]  ; too wide
+    e2: sys.util/rescue [draw-text:scale img 0x0 "A" file 64]  ; no slot left
+    delete file
+    all [
+        error? e1
+        error? e2
+        (pick img 1) = 255.255.255.255
+    ]
+)
+
+; DRAW fills and outlines shapes, clipped to the image
+(
+    img: make image! [6x6 255.255.255]
+    draw img [fill 255.0.0 pen off rect 1x1 3x3 pen 0.0.255 line 0x5 9x5]
+    all [
+        (pick img 1) = 255.255.255.255
+        (pick img 8) = 255.0.0.255  ; 1x1
+        (pick img 22) = 255.0.0.255  ; 3x3
+        (pick img 23) = 255.255.255.255  ; 4x3
+        (pick img 31) = 0.0.255.255  ; line along the bottom row
+        (pick img 36) = 0.0.255.255
+    ]
+)
+(
+    img: make image! [9x9 0.0.0.0]
+    draw:smooth img [fill 0.255.0 pen off circle 4x4 3]
+    center: pick img (4 * 9) + 5
+    edge: pick img (4 * 9) + 2  ; 3 pixels left of the center, half covered
+    all [
+        center = 0.255.0.255
+        edge.4 > 0
+        edge.4 < 255
+        (pick img 1) = 0.0.0.0
+    ]
+)
+
+; TRANSFORM turns and flips exactly, and maps with a matrix
+(
+    img: make image! [3x2 [
+        1.1.1 2.2.2 3.3.3
+        4.4.4 5.5.5 6.6.6
+    ]]
+    turned: transform img 'rotate-90
+    all [
+        turned.size = 2x3
+        (pick turned 1) = 4.4.4.255
+        (pick turned 2) = 1.1.1.255
+        (pick turned 6) = 3.3.3.255
+        img = transform (transform turned 'rotate-90) 'rotate-180
+        (transform img 'transpose) = transform (transform img 'rotate-90) 'flip-x
+        (pick transform img 'flip-y 1) = 4.4.4.255
+    ]
+)
+(
+    img: make image! [3x2 [
+        1.1.1 2.2.2 3.3.3
+        4.4.4 5.5.5 6.6.6
+    ]]
+    moved: transform img [1 0 0 1 1 0]
+    all [
+        img = transform img [1 0 0 1 0 0]
+        moved.size = 3x2
+        (pick moved 1) = 0.0.0.0
+        (pick moved 2) = 1.1.1.255
+        (pick moved 6) = 5.5.5.255
+    ]
+)
+(
+    img: make image! [3x2 255.0.0]
+    all [
+        null? try transform img [1 0 0 1 1e15 0]  ; too far to step in 16.16
+        error? sys.util/rescue [transform make image! 0x0 'bogus]
+    ]
+)